@@ -0,0 +1,65 @@
+#!/bin/bash
+# Compare pure MPI with hybrid MPI+OpenMP runs of the model kernel
+# benchmarks at a fixed number of cores. For every split of the cores
+# into processes x threads a JSON file with the timings is written,
+# the wall clock times of the kernels are summarized at the end.
+#
+# bench_models has to be built with -DIEMIC_OPENMP=ON, otherwise the
+# threads are idle and only the pure MPI runs are meaningful. Run this
+# in a directory with the xml parameter files of a coupled run (e.g.
+# test/global).
+
+if [ $# -lt 2 ]
+then
+    echo "usage: bench_hybrid.sh <bench_models executable> <cores> [mask]"
+    exit
+fi
+
+bench=$1
+cores=$2
+mask=${3:-mask_global_96x38x12}
+mintime=2
+
+# The private work arrays of the threaded Jacobian live on the thread
+# stacks
+export OMP_STACKSIZE=${OMP_STACKSIZE:-256M}
+export OMP_PROC_BIND=${OMP_PROC_BIND:-close}
+export OMP_PLACES=${OMP_PLACES:-cores}
+
+files=""
+nt=1
+while [ $nt -le $cores ]
+do
+    if [ $((cores % nt)) -eq 0 ]
+    then
+        np=$((cores / nt))
+        json=bench_${mask}_np${np}_nt${nt}.json
+        echo "Benchmarking $mask on $np processes x $nt threads..."
+        OMP_NUM_THREADS=$nt mpirun -np $np --bind-to none \
+                       $bench $mask $mintime $json > /dev/null
+        files="$files $json"
+    fi
+    nt=$((nt * 2))
+done
+
+# Mean time per kernel for every split
+printf "\n%-40s" "kernel"
+for json in $files
+do
+    printf "%14s" $(echo $json | sed 's/.*_\(np[0-9]*\)_\(nt[0-9]*\).json/\1x\2/')
+done
+printf "\n"
+
+kernels=$(grep '"name"' $(echo $files | cut -d' ' -f1) | \
+              sed 's/.*"name": "\([^/]*\)\/.*/\1/')
+for kernel in $kernels
+do
+    printf "%-40s" $kernel
+    for json in $files
+    do
+        time=$(grep -A3 "\"name\": \"$kernel/" $json | \
+                   grep real_time | sed 's/.*: \([^,]*\),/\1/')
+        printf "%14.4e" $time
+    done
+    printf "\n"
+done
@@ -0,0 +1,30 @@
+#!/bin/bash
+# Run the model kernel benchmarks for a range of land masks and
+# process counts. Every run writes a JSON file with the timings,
+# throughput and memory high-water mark, so runs can be compared
+# between releases.
+#
+# Run this in a directory with the xml parameter files of a coupled
+# run (e.g. test/global).
+
+if [ $# -lt 1 ]
+then
+    echo "usage: bench_scaling.sh <bench_models executable> [nprocs ...]"
+    exit
+fi
+
+bench=$1
+shift
+
+procs=${@:-1 2 4 8}
+masks="mask_global_48x19x4 mask_global_48x19x12 mask_global_96x38x12"
+mintime=2
+
+for mask in $masks
+do
+    for np in $procs
+    do
+        echo "Benchmarking $mask on $np processes..."
+        mpirun -np $np $bench $mask $mintime bench_${mask}_np${np}.json > /dev/null
+    done
+done
@@ -64,6 +64,30 @@ Call structure DSM and FDJS
 
       real time0, time1
 
+      call vmix_flags
+
+      vmix_time=0.0
+      call cpu_time(time0)
+
+      if (vmix_out.gt.0) write (99,'(a26)') 'MIX| init...              '
+      if (vmix_out.gt.0) write (99,'(a16,i10)') 'MIX|     flag:  ', vmix_flag
+
+      if (vmix_flag.eq.1) call vmix_part
+
+      call cpu_time(time1)
+      vmix_time=vmix_time+time1-time0
+      write (99,'(a26,f10.3)') 'MIX|          ...init done', time1-time0
+
+      end subroutine vmix_init
+
+!     * --------------------------------------------------------------------------------
+!     * reset the mixing flags, the part of vmix_init that does not
+!     * depend on the landmask
+      subroutine vmix_flags
+      use m_usr
+      use m_mix
+      implicit none
+
       if (vmix_GLB.eq.0) then
          vmix_flag = 0
          vmix_diff = 1
@@ -83,12 +107,6 @@ Call structure DSM and FDJS
          vmix_flag = -1
       endif 
 
-      vmix_time=0.0
-      call cpu_time(time0)
-
-      if (vmix_out.gt.0) write (99,'(a26)') 'MIX| init...              '
-      if (vmix_out.gt.0) write (99,'(a16,i10)') 'MIX|     flag:  ', vmix_flag
-
       select case (vmix_flag)
       case(0)
          vmix_temp=0
@@ -96,17 +114,12 @@ Call structure DSM and FDJS
       case(1)
          vmix_temp=1
          vmix_salt=1
-         call vmix_part
       case(2)
          vmix_temp=0
          vmix_salt=0
       end select
 
-      call cpu_time(time1)
-      vmix_time=vmix_time+time1-time0
-      write (99,'(a26,f10.3)') 'MIX|          ...init done', time1-time0
-
-      end subroutine vmix_init
+      end subroutine vmix_flags
 
 !     * --------------------------------------------------------------------------------
 !     * set mixing parameters
@@ -331,6 +344,10 @@ Call structure DSM and FDJS
       Fsimp(:,:,:)  = 0.0
 
 !     *L0s  start loop over k,j,i
+!     *     Every (i,j,k) only writes its own fluxes, the k,j columns are
+!     *     distributed over the OpenMP threads.
+!$omp parallel do collapse(2) schedule(static)
+!$omp&   private(i,j,k,ip,jq,kr,dumt,dums,drdh,drdz,slp,tpr)
       do k=1,l
          do j=1,m
 
@@ -495,10 +512,12 @@ Call structure DSM and FDJS
             enddo
          enddo
       enddo
+!$omp end parallel do
 !     *L0e  end loop over k,j,i
 
 !     *     Calculate divergence of the fluxes =========================================
 !     *L0s  start loop over k,j,i
+!$omp parallel do collapse(2) schedule(static) private(i,j,k,row)
       do k=1,l
          do j=1,m
             do i=1,n
@@ -557,6 +576,7 @@ Call structure DSM and FDJS
             enddo
          enddo
       enddo
+!$omp end parallel do
 !     *L0e  end loop over k,j,i
 
       end subroutine vmix_fun
@@ -750,8 +770,13 @@ Call structure DSM and FDJS
 
       select case(vmix_diff)
 !     *     Forward differences
+!     *     The column groups are structurally orthogonal: every group fills
+!     *     its own entries of fjac, so the groups can be evaluated by
+!     *     separate OpenMP threads. The private work arrays live on the
+!     *     thread stacks, set OMP_STACKSIZE accordingly.
       case(1)
          call vmix_fun(un,mix)
+!$omp parallel do schedule(dynamic) private(numgrp,j,d,und,mixd,col)
          do numgrp=1,vmix_maxgrp
             d = 0.0
             do j=1,ndim
@@ -769,8 +794,10 @@ Call structure DSM and FDJS
      +              vmix_ngrp,numgrp,d,mixd,fjac)
             endif
          enddo
+!$omp end parallel do
 !     *     Central differences      
       case(2)
+!$omp parallel do schedule(dynamic) private(numgrp,j,d,und,mix,mixd,col)
          do numgrp=1,vmix_maxgrp
             d = 0.0
             do j=1,ndim
@@ -790,10 +817,13 @@ Call structure DSM and FDJS
      +              vmix_ngrp,numgrp,d,mixd,fjac)
             endif
          enddo
+!$omp end parallel do
       end select
 ! note: row=i, columns are icol(ipntr(i):ipntr(i+1)-1)  
 
       numgrp = 0
+!     *     Different rows update different entries of an
+!$omp parallel do schedule(static) private(i,j,ix,iy,iz,ie,jx,jy,jz,je,s)
       do i=1,ndim               ! loop over rows, assumes col=.false. !!
          call findex(i,ix,iy,iz,ie)
          do j=vmix_ipntr(i),vmix_ipntr(i+1)-1 ! loop over columns (in approx.)
@@ -810,6 +840,7 @@ Call structure DSM and FDJS
             an(s,ie,je,ix,iy,iz) = an(s,ie,je,ix,iy,iz) + fjac(j)
          enddo
       enddo
+!$omp end parallel do
 
       end subroutine vmix_jac
 !     * --------------------------------------------------------------------------------
@@ -16,6 +16,41 @@
 
 #include "Trilinos_version.h"
 
+#ifdef HAVE_MPI
+
+// All groups of the ensemble use the same distribution of the state,
+// so every process exchanges its local part with the process with the
+// same rank in the other group.
+template<>
+void Transient<Teuchos::RCP<const Epetra_Vector> >::ensemble_send(
+    Teuchos::RCP<const Epetra_Vector> const &x, int group) const
+{
+    int rank;
+    MPI_Comm_rank(ensemble_comm_, &rank);
+
+    int dest = group * group_size_ + rank % group_size_;
+    CHECK_ZERO(MPI_Send(x->Values(), x->MyLength(), MPI_DOUBLE,
+                        dest, 0, ensemble_comm_));
+}
+
+template<>
+Teuchos::RCP<const Epetra_Vector>
+Transient<Teuchos::RCP<const Epetra_Vector> >::ensemble_recv(
+    Teuchos::RCP<const Epetra_Vector> const &x0, int group) const
+{
+    int rank;
+    MPI_Comm_rank(ensemble_comm_, &rank);
+
+    Teuchos::RCP<Epetra_Vector> x = Teuchos::rcp(new Epetra_Vector(x0->Map()));
+
+    int src = group * group_size_ + rank % group_size_;
+    CHECK_ZERO(MPI_Recv(x->Values(), x->MyLength(), MPI_DOUBLE,
+                        src, 0, ensemble_comm_, MPI_STATUS_IGNORE));
+    return x;
+}
+
+#endif // HAVE_MPI
+
 // This read/write mechanism need Trilinos pull request #3381, which
 // is present in Trilinos 12.14
 #if TRILINOS_MAJOR_MINOR_VERSION > 121300
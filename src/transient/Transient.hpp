@@ -9,7 +9,16 @@
 #include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <exception>
+#include <set>
 
+namespace Teuchos { template<class T> class RCP; }
+
+// The states in xlist are stored as handles. For reference counted
+// handles, experiments that are branched from the same trajectory
+// share the states of their common prefix instead of copying them,
+// and a state is released once no experiment refers to it anymore.
 template<class T>
 struct AMSExperiment {
     T x0;
@@ -55,6 +64,20 @@ struct GPAExperiment {
     bool converged;
 };
 
+// Identify a stored state, such that states that are shared between
+// experiments are only counted once
+template<class S>
+void const *snapshot_id(S const &x)
+{
+    return &x;
+}
+
+template<class S>
+void const *snapshot_id(Teuchos::RCP<S> const &x)
+{
+    return x.get();
+}
+
 std::string mem2string(long long mem)
 {
     double value = mem;
@@ -77,9 +100,15 @@ Transient<T>::Transient(std::function<T(T const &, double)> time_step)
     time_step_(time_step),
     method_("Transient"),
     x0_(nullptr),
+    time_steps_(0),
     mfpt_(-1),
     probability_(-1),
-    engine_initialized_(false)
+    engine_initialized_(false),
+    seed_(0),
+    group_rank_(0),
+    num_groups_(1),
+    group_(0),
+    group_size_(0)
 {}
 
 template<class T>
@@ -89,9 +118,15 @@ Transient<T>::Transient(std::function<T(T const &, double)> time_step,
     time_step_(time_step),
     method_("Transient"),
     x0_(new T(x0)),
+    time_steps_(0),
     mfpt_(-1),
     probability_(-1),
-    engine_initialized_(false)
+    engine_initialized_(false),
+    seed_(0),
+    group_rank_(0),
+    num_groups_(1),
+    group_(0),
+    group_size_(0)
 {}
 
 template<class T>
@@ -104,9 +139,15 @@ Transient<T>::Transient(std::function<T(T const &, double)> time_step,
     method_("TAMS"),
     x0_(nullptr),
     vector_length_(vector_length),
+    time_steps_(0),
     mfpt_(-1),
     probability_(-1),
-    engine_initialized_(false)
+    engine_initialized_(false),
+    seed_(0),
+    group_rank_(0),
+    num_groups_(1),
+    group_(0),
+    group_size_(0)
 {}
 
 template<class T>
@@ -120,9 +161,15 @@ Transient<T>::Transient(std::function<T(T const &, double)> time_step,
     method_("TAMS"),
     x0_(new T(x0)),
     vector_length_(vector_length),
+    time_steps_(0),
     mfpt_(-1),
     probability_(-1),
-    engine_initialized_(false)
+    engine_initialized_(false),
+    seed_(0),
+    group_rank_(0),
+    num_groups_(1),
+    group_(0),
+    group_size_(0)
 {}
 
 template<class T>
@@ -156,6 +203,7 @@ void Transient<T>::set_parameters(ParameterList &params)
     write_final_ = params.get("write final state", true);
     write_steps_ = params.get("write steps", -1);
     write_time_steps_ = params.get("write time steps", -1);
+    cleanup_steps_ = params.get("cleanup steps", 10);
 
     if (num_init_exp_ < num_exp_)
         num_init_exp_ = num_exp_;
@@ -186,7 +234,7 @@ double Transient<T>::transient_max_distance(
 template<class T>
 void Transient<T>::transient_start(
     T const &x0, double dt, double tmax,
-    AMSExperiment<T> &experiment) const
+    AMSExperiment<T> &experiment, int worker) const
 {
     T x(x0);
 
@@ -194,7 +242,7 @@ void Transient<T>::transient_start(
 
     for (double t = dt; t <= tmax; t += dt)
     {
-        x = std::move(time_step_helper(x, dt));
+        x = std::move(time_step_helper(x, dt, worker));
 
         double dist = dist_fun_(x);
         if (dist > cdist_)
@@ -213,7 +261,7 @@ void Transient<T>::transient_start(
 template<class T>
 void Transient<T>::transient_ams(
     double dt, double tmax,
-    AMSExperiment<T> &experiment) const
+    AMSExperiment<T> &experiment, int worker) const
 {
     T x(experiment.xlist.back());
     double t = experiment.tlist.back() + dt;
@@ -223,7 +271,7 @@ void Transient<T>::transient_ams(
 
     for (; t <= tend; t += dt)
     {
-        x = std::move(time_step_helper(x, dt));
+        x = std::move(time_step_helper(x, dt, worker));
 
         double dist = dist_fun_(x);
 
@@ -258,7 +306,7 @@ void Transient<T>::transient_ams(
 template<class T>
 void Transient<T>::transient_tams(
     double dt, double tmax,
-    AMSExperiment<T> &experiment) const
+    AMSExperiment<T> &experiment, int worker) const
 {
     T x(experiment.xlist.back());
     double t = experiment.tlist.back() + dt;
@@ -267,7 +315,7 @@ void Transient<T>::transient_tams(
 
     for (; t <= tmax; t += dt)
     {
-        x = std::move(time_step_helper(x, dt));
+        x = std::move(time_step_helper(x, dt, worker));
 
         double dist = dist_fun_(x);
         if (dist > 1 - bdist_)
@@ -352,6 +400,12 @@ double Transient<T>::ams_elimination(
     for (int i = 0; i < num_exp_; i++)
         reactive_experiments.push_back(&experiments[i]);
 
+    auto index = [&reactive_experiments](AMSExperiment<T> const *exp) {
+        return std::find(reactive_experiments.begin(),
+                         reactive_experiments.end(),
+                         exp) - reactive_experiments.begin();
+    };
+
     for (auto exp: reactive_experiments)
     {
         if (!exp->converged)
@@ -399,9 +453,13 @@ double Transient<T>::ams_elimination(
 
         its_++;
 
+        // Branch all eliminated trajectories before integrating them,
+        // such that the random choices do not depend on the order in
+        // which the trajectories finish.
+        std::vector<double> old_max_distances;
         for (auto &exp: minimal_experiments)
         {
-            double max_distance = exp->max_distance;
+            old_max_distances.push_back(exp->max_distance);
             int rnd_idx = randint(0, unused_experiments.size()-1);
             while (unused_experiments[rnd_idx]->max_distance <= exp->max_distance)
                 rnd_idx = randint(0, unused_experiments.size()-1);
@@ -423,22 +481,46 @@ double Transient<T>::ams_elimination(
                       << rnd_exp->max_distance << ".", __FILE__, __LINE__);
             }
 
+            if (num_groups_ > 1)
+            {
+                ensemble_branch(*exp, index(exp), *rnd_exp, index(rnd_exp),
+                                same_distance_idx);
+                continue;
+            }
+
+            // This only copies the handles, the states are shared
             exp->xlist = std::vector<T>(
                 rnd_exp->xlist.begin(), rnd_exp->xlist.begin() + same_distance_idx + 1);
             exp->dlist = std::vector<double>(
                 rnd_exp->dlist.begin(), rnd_exp->dlist.begin() + same_distance_idx + 1);
             exp->tlist = std::vector<double>(
                 rnd_exp->tlist.begin(), rnd_exp->tlist.begin() + same_distance_idx + 1);
+        }
 
-            if (method == "AMS")
-                transient_ams(dt, tmax, *exp);
-            else if (method == "TAMS")
-                transient_tams(dt, tmax, *exp);
-            else
-            {
-                ERROR("Method " << method << " does not exist.", __FILE__, __LINE__);
-            }
+        if (method != "AMS" && method != "TAMS")
+        {
+            ERROR("Method " << method << " does not exist.", __FILE__, __LINE__);
+        }
+
+        std::vector<std::function<void(int)> > tasks;
+        std::vector<int> indices;
+        for (auto &exp: minimal_experiments)
+        {
+            tasks.push_back([this, &method, exp, dt, tmax](int worker) {
+                    if (method == "AMS")
+                        transient_ams(dt, tmax, *exp, worker);
+                    else
+                        transient_tams(dt, tmax, *exp, worker);
+                });
+            indices.push_back(index(exp));
+        }
+
+        run_tasks(tasks, indices, its_);
+        ensemble_sync(minimal_experiments, indices);
 
+        for (int j = 0; j < (int)minimal_experiments.size(); j++)
+        {
+            AMSExperiment<T> *exp = minimal_experiments[j];
             if (exp->converged)
                 converged++;
             else
@@ -447,13 +529,10 @@ double Transient<T>::ams_elimination(
             INFO(method << ": " << its_ << " / " << maxit_ << ", "
                  << converged << " / " << num_exp_
                  << " converged with max distance "
-                 << max_distance << " -> "
+                 << old_max_distances[j] << " -> "
                  << exp->max_distance << " and t="
                  << exp->initial_time + exp->time
-                 << " for experiment "
-                 << std::find(reactive_experiments.begin(),
-                              reactive_experiments.end(),
-                              exp) - reactive_experiments.begin());
+                 << " for experiment " << indices[j]);
         }
 
         for (auto &exp: minimal_experiments)
@@ -467,7 +546,7 @@ double Transient<T>::ams_elimination(
         for (auto exp: reactive_experiments)
             min_max_distance = std::min(min_max_distance, exp->max_distance);
 
-        if (its_ % 10 == 0)
+        if (cleanup_steps_ > 0 && its_ % cleanup_steps_ == 0)
         {
             INFO("Starting cleanup");
             for (auto exp: unused_experiments)
@@ -478,9 +557,11 @@ double Transient<T>::ams_elimination(
 
                 if (min_max_idx > 0)
                 {
-                    exp->xlist = std::vector<T>(
-                        exp->xlist.begin() + min_max_idx,
-                        exp->xlist.end());
+                    // Other groups of the ensemble do not store the states
+                    if (!exp->xlist.empty())
+                        exp->xlist = std::vector<T>(
+                            exp->xlist.begin() + min_max_idx,
+                            exp->xlist.end());
                     exp->dlist = std::vector<double>(
                         exp->dlist.begin() + min_max_idx,
                         exp->dlist.end());
@@ -489,7 +570,8 @@ double Transient<T>::ams_elimination(
                         exp->tlist.end());
                 }
             }
-            INFO("Finished cleanup");
+            INFO("Finished cleanup, stored states use "
+                 << mem2string(snapshot_memory(experiments)));
         }
 
         write_helper(experiments, its_);
@@ -520,6 +602,12 @@ void Transient<T>::ams(T const &x0) const
     its_ = 0;
     time_steps_ = 0;
 
+    if (num_groups_ > 1 && (read_ != "" || write_ != ""))
+    {
+        ERROR("Reading and writing is not supported for an ensemble of groups",
+              __FILE__, __LINE__);
+    }
+
     if (read_ != "")
         read(read_, experiments);
 
@@ -527,37 +615,64 @@ void Transient<T>::ams(T const &x0) const
     double tmax = 100 * tmax_;
     time_steps_previous_write_ = 0;
 
+    std::vector<std::function<void(int)> > tasks;
+    std::vector<int> indices;
     for (int i = 0; i < num_init_exp_; i++)
     {
         if (experiments[i].initialized)
             continue;
 
-        transient_start(x0, dt_, tmax, experiments[i]);
+        AMSExperiment<T> *exp = &experiments[i];
+        tasks.push_back([this, &x0, exp, tmax](int worker) {
+                transient_start(x0, dt_, tmax, *exp, worker);
+                if (exp->xlist.size() > 0)
+                    transient_ams(dt_, tmax, *exp, worker);
+            });
+        indices.push_back(i);
+    }
 
-        if (experiments[i].xlist.size() == 0)
+    // Integrate the initial trajectories, one per worker at a time
+    int chunk = std::max(num_workers(), 1) * num_groups_;
+    for (int first = 0; first < (int)tasks.size(); first += chunk)
+    {
+        int last = std::min(first + chunk, (int)tasks.size());
+        std::vector<int> chunk_indices(
+            indices.begin() + first, indices.begin() + last);
+        run_tasks(std::vector<std::function<void(int)> >(
+                      tasks.begin() + first, tasks.begin() + last),
+                  chunk_indices, 0);
+
+        std::vector<AMSExperiment<T> *> chunk_experiments;
+        for (int i: chunk_indices)
+            chunk_experiments.push_back(&experiments[i]);
+        ensemble_sync(chunk_experiments, chunk_indices);
+
+        for (int j = first; j < last; j++)
         {
-            ERROR("Initialization failed", __FILE__, __LINE__);
-        }
-
-        transient_ams(dt_, tmax, experiments[i]);
+            int i = indices[j];
+            if (experiments[i].dlist.size() == 0)
+            {
+                ERROR("Initialization failed", __FILE__, __LINE__);
+            }
 
-        // Erase data that we do not need for later experiments
-        if (i >= num_exp_)
-        {
-            experiments[i].xlist = std::vector<T>();
-            experiments[i].dlist = std::vector<double>();
-            experiments[i].tlist = std::vector<double>();
-        }
+            // Erase data that we do not need for later experiments
+            if (i >= num_exp_)
+            {
+                experiments[i].xlist = std::vector<T>();
+                experiments[i].dlist = std::vector<double>();
+                experiments[i].tlist = std::vector<double>();
+            }
 
-        if (experiments[i].converged)
-            converged++;
+            if (experiments[i].converged)
+                converged++;
 
-        INFO("Initialization: " << i+1 << " / " << num_init_exp_ << ", "
-             << converged << " / " << num_init_exp_
-             << " converged with t="
-             << experiments[i].initial_time + experiments[i].time);
+            INFO("Initialization: " << i+1 << " / " << num_init_exp_ << ", "
+                 << converged << " / " << num_init_exp_
+                 << " converged with t="
+                 << experiments[i].initial_time + experiments[i].time);
 
-        write_helper(experiments, i+1);
+            write_helper(experiments, i+1);
+        }
     }
     INFO("");
 
@@ -608,12 +723,20 @@ void Transient<T>::tams(T const &x0) const
     its_ = 0;
     time_steps_ = 0;
 
+    if (num_groups_ > 1 && (read_ != "" || write_ != ""))
+    {
+        ERROR("Reading and writing is not supported for an ensemble of groups",
+              __FILE__, __LINE__);
+    }
+
     if (read_ != "")
         read(read_, experiments);
 
     int converged = 0;
     time_steps_previous_write_ = 0;
 
+    std::vector<std::function<void(int)> > tasks;
+    std::vector<int> indices;
     for (int i = 0; i < num_exp_; i++)
     {
         if (experiments[i].initialized)
@@ -623,19 +746,44 @@ void Transient<T>::tams(T const &x0) const
         experiments[i].dlist.push_back(0);
         experiments[i].tlist.push_back(0);
 
-        transient_tams(dt_, tmax_, experiments[i]);
+        AMSExperiment<T> *exp = &experiments[i];
+        tasks.push_back([this, exp](int worker) {
+                transient_tams(dt_, tmax_, *exp, worker);
+            });
+        indices.push_back(i);
+    }
 
-        experiments[i].initialized = true;
+    // Integrate the initial trajectories, one per worker at a time
+    int chunk = std::max(num_workers(), 1) * num_groups_;
+    for (int first = 0; first < (int)tasks.size(); first += chunk)
+    {
+        int last = std::min(first + chunk, (int)tasks.size());
+        std::vector<int> chunk_indices(
+            indices.begin() + first, indices.begin() + last);
+        run_tasks(std::vector<std::function<void(int)> >(
+                      tasks.begin() + first, tasks.begin() + last),
+                  chunk_indices, 0);
+
+        std::vector<AMSExperiment<T> *> chunk_experiments;
+        for (int i: chunk_indices)
+            chunk_experiments.push_back(&experiments[i]);
+        ensemble_sync(chunk_experiments, chunk_indices);
+
+        for (int j = first; j < last; j++)
+        {
+            int i = indices[j];
+            experiments[i].initialized = true;
 
-        if (experiments[i].converged)
-            converged++;
+            if (experiments[i].converged)
+                converged++;
 
-        INFO("Initialization: " << i+1 << " / " << num_exp_ << ", "
-             << converged << " / " << num_exp_
-             << " converged with t="
-             << experiments[i].time);
+            INFO("Initialization: " << i+1 << " / " << num_exp_ << ", "
+                 << converged << " / " << num_exp_
+                 << " converged with t="
+                 << experiments[i].time);
 
-        write_helper(experiments, i+1);
+            write_helper(experiments, i+1);
+        }
     }
     INFO("");
 
@@ -728,6 +876,8 @@ void Transient<T>::set_random_engine(unsigned int seed)
     if (engine_initialized_)
         delete engine_;
 
+    seed_ = seed;
+
     std::seed_seq seeder{seed};
     engine_ = new std::mt19937_64(seeder);
 
@@ -744,6 +894,28 @@ void Transient<T>::set_random_engine(unsigned int seed)
     engine_initialized_ = true;
 }
 
+template<class T>
+void Transient<T>::set_noise_seed(std::function<void(std::uint64_t)> seed,
+                                  int rank)
+{
+    noise_seed_ = seed;
+    group_rank_ = rank;
+}
+
+template<class T>
+void Transient<T>::add_worker(std::function<T(T const &, double)> time_step,
+                              std::function<void(std::uint64_t)> seed)
+{
+    worker_time_step_.push_back(time_step);
+    worker_seed_.push_back(seed);
+}
+
+template<class T>
+int Transient<T>::num_workers() const
+{
+    return worker_time_step_.size();
+}
+
 template<class T>
 int Transient<T>::randint(int a, int b) const
 {
@@ -785,12 +957,229 @@ int Transient<T>::randreal(double a, double b) const
 }
 
 template<class T>
-T Transient<T>::time_step_helper(T const &x, double dt) const
+T Transient<T>::time_step_helper(T const &x, double dt, int worker) const
 {
     time_steps_++;
+    if (worker >= 0)
+        return std::move(worker_time_step_[worker](x, dt));
     return std::move(time_step_(x, dt));
 }
 
+template<class T>
+std::uint64_t Transient<T>::task_seed(int round, int index) const
+{
+    // The noise of a trajectory only depends on the global seed, the
+    // elimination round, the experiment and the subdomain, not on the
+    // worker or the group that integrates it.
+    std::seed_seq seeder{seed_, (unsigned int)round, (unsigned int)index,
+                         (unsigned int)group_rank_};
+    std::mt19937_64 engine(seeder);
+    return engine();
+}
+
+template<class T>
+void Transient<T>::run_tasks(std::vector<std::function<void(int)> > const &tasks,
+                             std::vector<int> const &indices, int round) const
+{
+    int num_tasks = tasks.size();
+
+    // Without workers we integrate in the main thread with the
+    // original time stepper
+    if (num_workers() == 0)
+    {
+        for (int k = 0; k < num_tasks; k++)
+        {
+            if (owner(indices[k]) != group_)
+                continue;
+
+            if (noise_seed_)
+                noise_seed_(task_seed(round, indices[k]));
+            tasks[k](-1);
+        }
+        return;
+    }
+
+    std::atomic<int> next_task(0);
+    std::vector<std::exception_ptr> errors(num_workers());
+
+    auto work = [&](int worker) {
+        try
+        {
+            int k;
+            while ((k = next_task++) < num_tasks)
+            {
+                if (owner(indices[k]) != group_)
+                    continue;
+
+                worker_seed_[worker](task_seed(round, indices[k]));
+                tasks[k](worker);
+            }
+        }
+        catch (...)
+        {
+            errors[worker] = std::current_exception();
+        }
+    };
+
+    int num_threads = std::min(num_workers(), num_tasks);
+    if (num_threads <= 1)
+        work(0);
+    else
+    {
+        std::vector<std::thread> threads;
+        for (int w = 0; w < num_threads; w++)
+            threads.push_back(std::thread(work, w));
+        for (auto &thread: threads)
+            thread.join();
+    }
+
+    for (auto &error: errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+#ifdef HAVE_MPI
+template<class T>
+void Transient<T>::set_ensemble(MPI_Comm comm, int num_groups)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    if (num_groups < 1 || size % num_groups != 0)
+    {
+        ERROR("Number of processes " << size << " is not divisible by the "
+              "number of ensemble groups " << num_groups, __FILE__, __LINE__);
+    }
+
+    ensemble_comm_ = comm;
+    num_groups_ = num_groups;
+    group_size_ = size / num_groups;
+    group_ = rank / group_size_;
+}
+#endif
+
+template<class T>
+int Transient<T>::num_groups() const
+{
+    return num_groups_;
+}
+
+template<class T>
+int Transient<T>::owner(int index) const
+{
+    return index % num_groups_;
+}
+
+template<class T>
+void Transient<T>::ensemble_sync(
+    std::vector<AMSExperiment<T> *> const &experiments,
+    std::vector<int> const &indices) const
+{
+    if (num_groups_ == 1)
+        return;
+
+#ifdef HAVE_MPI
+    TIMER_SCOPE("AMS: Ensemble synchronization");
+
+    // Only the distances and times are sent to the other groups. The
+    // states are sent when they are needed for branching.
+    for (int j = 0; j < (int)experiments.size(); j++)
+    {
+        AMSExperiment<T> &exp = *experiments[j];
+        int root = owner(indices[j]) * group_size_;
+
+        std::vector<double> data = {
+            exp.max_distance, exp.time, exp.initial_time, exp.return_time,
+            (double)exp.converged, (double)exp.initialized,
+            (double)exp.dlist.size()};
+        MPI_Bcast(&data[0], data.size(), MPI_DOUBLE, root, ensemble_comm_);
+
+        exp.max_distance = data[0];
+        exp.time = data[1];
+        exp.initial_time = data[2];
+        exp.return_time = data[3];
+        exp.converged = data[4] > 0.5;
+        exp.initialized = data[5] > 0.5;
+
+        int size = data[6];
+        exp.dlist.resize(size);
+        exp.tlist.resize(size);
+        if (size > 0)
+        {
+            MPI_Bcast(&exp.dlist[0], size, MPI_DOUBLE, root, ensemble_comm_);
+            MPI_Bcast(&exp.tlist[0], size, MPI_DOUBLE, root, ensemble_comm_);
+        }
+
+        if (owner(indices[j]) != group_)
+            exp.xlist.clear();
+    }
+#endif
+}
+
+template<class T>
+void Transient<T>::ensemble_branch(
+    AMSExperiment<T> &experiment, int index,
+    AMSExperiment<T> const &source, int source_index,
+    int snapshot) const
+{
+    // Earlier states are never used for branching again (see the
+    // cleanup in ams_elimination), so only the snapshot is copied,
+    // and sent to the owner if it lives in another group.
+    experiment.dlist = std::vector<double>(1, source.dlist[snapshot]);
+    experiment.tlist = std::vector<double>(1, source.tlist[snapshot]);
+
+    int dest = owner(index);
+    int src = owner(source_index);
+    if (dest == src)
+    {
+        if (dest == group_)
+            experiment.xlist = std::vector<T>(1, source.xlist[snapshot]);
+        else
+            experiment.xlist.clear();
+    }
+    else if (src == group_)
+    {
+        TIMER_SCOPE("AMS: Ensemble branching");
+        ensemble_send(source.xlist[snapshot], dest);
+        experiment.xlist.clear();
+    }
+    else if (dest == group_)
+    {
+        TIMER_SCOPE("AMS: Ensemble branching");
+        experiment.xlist = std::vector<T>(1, ensemble_recv(experiment.x0, src));
+    }
+    else
+        experiment.xlist.clear();
+}
+
+template<class T>
+void Transient<T>::ensemble_send(T const &x, int group) const
+{
+    ERROR("Sending states to other groups is not implemented.",
+          __FILE__, __LINE__);
+}
+
+template<class T>
+T Transient<T>::ensemble_recv(T const &x0, int group) const
+{
+    ERROR("Receiving states from other groups is not implemented.",
+          __FILE__, __LINE__);
+    return x0;
+}
+
+template<class T>
+long long Transient<T>::snapshot_memory(
+    std::vector<AMSExperiment<T> > const &experiments) const
+{
+    std::set<void const *> snapshots;
+    for (auto &exp: experiments)
+        for (auto &x: exp.xlist)
+            snapshots.insert(snapshot_id(x));
+
+    return (long long)snapshots.size() * vector_length_ * sizeof(double);
+}
+
 template<class T>
 void Transient<T>::write_helper(std::vector<AMSExperiment<T> > const &experiments,
                                 int its) const
@@ -879,13 +1268,21 @@ double Transient<T>::get_mfpt()
     return mfpt_;
 }
 
+class Epetra_Vector;
+
+template<>
+void Transient<Teuchos::RCP<const Epetra_Vector> >::ensemble_send(
+    Teuchos::RCP<const Epetra_Vector> const &x, int group) const;
+
+template<>
+Teuchos::RCP<const Epetra_Vector>
+Transient<Teuchos::RCP<const Epetra_Vector> >::ensemble_recv(
+    Teuchos::RCP<const Epetra_Vector> const &x0, int group) const;
+
 #include "Trilinos_version.h"
 
 #if TRILINOS_MAJOR_MINOR_VERSION > 121300
 
-namespace Teuchos { template<class T> class RCP; }
-class Epetra_Vector;
-
 template<>
 void Transient<Teuchos::RCP<const Epetra_Vector> >::read(
     std::string const &name,
@@ -3,6 +3,15 @@
 
 #include <random>
 #include <functional>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <Epetra_config.h>
+
+#ifdef HAVE_MPI
+#  include <mpi.h>
+#endif
 
 template<class T>
 class AMSExperiment;
@@ -37,7 +46,7 @@ class Transient
 
     int maxit_;
     mutable int its_;
-    mutable int time_steps_;
+    mutable std::atomic<int> time_steps_;
     mutable int time_steps_previous_write_;
 
     std::string read_;
@@ -45,6 +54,7 @@ class Transient
     bool write_final_;
     int write_steps_;
     int write_time_steps_;
+    int cleanup_steps_;
 
     mutable double mfpt_;
     mutable double probability_;
@@ -54,8 +64,32 @@ class Transient
     std::function<int(int, int)> randint_;
     std::function<double(double, double)> randreal_;
 
-    // Random engine. FIXME: Does not work with omp!!!
+    // Random engine, only used by the main thread
     std::mt19937_64 *engine_;
+    unsigned int seed_;
+
+    // Reseeds the noise of the main time stepper before every
+    // trajectory, and the rank of this process within the
+    // communicator of its model. The rank is mixed into the seeds,
+    // such that every subdomain draws its own noise.
+    std::function<void(std::uint64_t)> noise_seed_;
+    int group_rank_;
+
+    // Workers that integrate trajectories in parallel. Each worker
+    // has its own time stepper and a function that reseeds its noise.
+    std::vector<std::function<T(T const &, double)> > worker_time_step_;
+    std::vector<std::function<void(std::uint64_t)> > worker_seed_;
+
+    // Ensemble of process groups that each own a model and integrate
+    // their own share of the experiments. Experiment i is owned by
+    // group i % num_groups_. All groups know the distances and times
+    // of all experiments, but only the owner stores the states.
+#ifdef HAVE_MPI
+    MPI_Comm ensemble_comm_;
+#endif
+    int num_groups_;
+    int group_;
+    int group_size_;
 
 public:
     Transient(std::function<T(T const &, double)> time_step);
@@ -81,15 +115,15 @@ public:
 
     void transient_start(
         T const &x0, double dt, double tmax,
-        AMSExperiment<T> &experiment) const;
+        AMSExperiment<T> &experiment, int worker = -1) const;
 
     void transient_ams(
         double dt, double tmax,
-        AMSExperiment<T> &experiment) const;
+        AMSExperiment<T> &experiment, int worker = -1) const;
 
     void transient_tams(
         double dt, double tmax,
-        AMSExperiment<T> &experiment) const;
+        AMSExperiment<T> &experiment, int worker = -1) const;
 
     void transient_gpa(
         double dt, double tmax,
@@ -121,6 +155,19 @@ public:
 
     void set_random_engine(unsigned int seed);
 
+    void set_noise_seed(std::function<void(std::uint64_t)> seed, int rank);
+
+    void add_worker(std::function<T(T const &, double)> time_step,
+                    std::function<void(std::uint64_t)> seed);
+
+    int num_workers() const;
+
+#ifdef HAVE_MPI
+    void set_ensemble(MPI_Comm comm, int num_groups);
+#endif
+
+    int num_groups() const;
+
     double get_probability();
     double get_mfpt();
 
@@ -128,10 +175,31 @@ protected:
     int randint(int a, int b) const;
     int randreal(double a, double b) const;
 
-    T time_step_helper(T const &x, double dt) const;
+    T time_step_helper(T const &x, double dt, int worker = -1) const;
+
+    std::uint64_t task_seed(int round, int index) const;
+
+    void run_tasks(std::vector<std::function<void(int)> > const &tasks,
+                   std::vector<int> const &indices, int round) const;
 
     void write_helper(std::vector<AMSExperiment<T> > const &experiments,
                       int its) const;
+
+    long long snapshot_memory(
+        std::vector<AMSExperiment<T> > const &experiments) const;
+
+    int owner(int index) const;
+
+    void ensemble_sync(std::vector<AMSExperiment<T> *> const &experiments,
+                       std::vector<int> const &indices) const;
+
+    void ensemble_branch(AMSExperiment<T> &experiment, int index,
+                         AMSExperiment<T> const &source, int source_index,
+                         int snapshot) const;
+
+    void ensemble_send(T const &x, int group) const;
+
+    T ensemble_recv(T const &x0, int group) const;
 };
 
 #endif